@@ -100,17 +100,30 @@ static const unsigned char aes_test_cfb_enc[3][16] =
       0x41, 0x78, 0x91, 0xD5, 0x98, 0x78, 0xE1, 0xFA }
 };
 
+#define AES_BULK_LEN    ( 67 * 16 )
+#define AES_STREAMS     4
+#define AES_STREAM_LEN  ( 16 * 16 )
+
 int verbose = 1;
 
 int
 main(void)
 {
-    int i, j, u, v, offset;
+    int i, j, m, o, u, v, offset;
     unsigned char key[32];
     unsigned char buf[16];
     unsigned char prv[16];
     unsigned char iv[16];
+    unsigned char raw[48];
+    unsigned char *p, *q;
+    const unsigned char *r;
+    unsigned char bulk_pt[AES_BULK_LEN];
+    unsigned char bulk_ct[AES_BULK_LEN];
+    unsigned char bulk_buf[AES_BULK_LEN];
+    unsigned char stream_key[32];
+    unsigned char stream_iv[AES_STREAMS][16];
     aes_context ctx;
+    aes_context stream_ctx[AES_STREAMS];
 
     memset( key, 0, 32 );
 
@@ -283,5 +296,222 @@ main(void)
     if( verbose != 0 )
         printf( "\n" );
 
+    /*
+     * ECB, CBC and CFB mode again, with the block and IV at every odd
+     * offset
+     */
+    for( i = 0; i < 18; i++ )
+    {
+        m = i / 6;
+        u = ( i % 6 ) >> 1;
+        v = i  & 1;
+
+        if( verbose != 0 )
+            printf( "  AES-%s-%3d (%s, unaligned): ",
+                    ( m == 0 ) ? "ECB" : ( m == 1 ) ? "CBC" : "CFB",
+                    128 + u * 64, ( v == AES_DECRYPT ) ? "dec" : "enc" );
+
+        if( m == 0 )
+            r = ( v == AES_DECRYPT ) ? aes_test_ecb_dec[u]
+                                     : aes_test_ecb_enc[u];
+        else if( m == 1 )
+            r = ( v == AES_DECRYPT ) ? aes_test_cbc_dec[u]
+                                     : aes_test_cbc_enc[u];
+        else
+            r = ( v == AES_DECRYPT ) ? aes_test_cfb_dec[u]
+                                     : aes_test_cfb_enc[u];
+
+        if( v == AES_DECRYPT )
+            aes_setkey_dec( &ctx, key, 128 + u * 64 );
+        else
+            aes_setkey_enc( &ctx, key, 128 + u * 64 );
+
+        for( o = 1; o < 16; o += 2 )
+        {
+            memset( raw, 0, 48 );
+            memset( prv, 0, 16 );
+            p = raw + o;
+            q = p + 16;
+            offset = 0;
+
+            for( j = 0; j < 10000; j++ )
+            {
+                unsigned char tmp[16];
+
+                if( m == 0 )
+                    aes_crypt_ecb( &ctx, v, p, p );
+                else if( m == 1 )
+                    aes_crypt_cbc( &ctx, v, 16, q, p, p );
+                else
+                    aes_crypt_cfb( &ctx, v, 16, &offset, q, p, p );
+
+                if( m == 1 && v != AES_DECRYPT )
+                {
+                    memcpy( tmp, prv, 16 );
+                    memcpy( prv, p, 16 );
+                    memcpy( p, tmp, 16 );
+                }
+            }
+
+            if( m == 1 && v != AES_DECRYPT )
+                p = prv;
+
+            if( memcmp( p, r, 16 ) != 0 )
+            {
+                if( verbose != 0 )
+                    printf( "failed\n" );
+
+                return( 1 );
+            }
+        }
+
+        if( verbose != 0 )
+            printf( "passed\n" );
+    }
+
+    if( verbose != 0 )
+        printf( "\n" );
+
+    /*
+     * CBC and CFB mode, multi-block decryption
+     */
+    for( i = 0; i < 6; i++ )
+    {
+        u = i >> 1;
+        v = i  & 1;
+
+        if( verbose != 0 )
+            printf( "  AES-%s-%3d (dec, %d bytes): ",
+                    ( v == 0 ) ? "CBC" : "CFB", 128 + u * 64,
+                    AES_BULK_LEN );
+
+        for( j = 0; j < AES_BULK_LEN; j++ )
+            bulk_pt[j] = (unsigned char)( j * 7 + u );
+
+        aes_setkey_enc( &ctx, key, 128 + u * 64 );
+
+        memset( iv, 0, 16 );
+        offset = 0;
+
+        if( v == 0 )
+            aes_crypt_cbc( &ctx, AES_ENCRYPT, AES_BULK_LEN, iv,
+                           bulk_pt, bulk_ct );
+        else
+            aes_crypt_cfb( &ctx, AES_ENCRYPT, AES_BULK_LEN, &offset, iv,
+                           bulk_pt, bulk_ct );
+
+        if( v == 0 )
+            aes_setkey_dec( &ctx, key, 128 + u * 64 );
+
+        /*
+         * whole buffer in one call, in place
+         */
+        memcpy( bulk_buf, bulk_ct, AES_BULK_LEN );
+        memset( iv, 0, 16 );
+        offset = 0;
+
+        if( v == 0 )
+            aes_crypt_cbc( &ctx, AES_DECRYPT, AES_BULK_LEN, iv,
+                           bulk_buf, bulk_buf );
+        else
+            aes_crypt_cfb( &ctx, AES_DECRYPT, AES_BULK_LEN, &offset, iv,
+                           bulk_buf, bulk_buf );
+
+        memcpy( prv, iv, 16 );
+
+        if( memcmp( bulk_buf, bulk_pt, AES_BULK_LEN ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        /*
+         * one block at a time, the chaining value must end up the same
+         */
+        memset( iv, 0, 16 );
+        offset = 0;
+
+        for( j = 0; j < AES_BULK_LEN; j += 16 )
+        {
+            if( v == 0 )
+                aes_crypt_cbc( &ctx, AES_DECRYPT, 16, iv,
+                               bulk_ct + j, buf );
+            else
+                aes_crypt_cfb( &ctx, AES_DECRYPT, 16, &offset, iv,
+                               bulk_ct + j, buf );
+
+            if( memcmp( buf, bulk_pt + j, 16 ) != 0 )
+            {
+                if( verbose != 0 )
+                    printf( "failed\n" );
+
+                return( 1 );
+            }
+        }
+
+        if( memcmp( iv, prv, 16 ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        if( verbose != 0 )
+            printf( "passed\n" );
+    }
+
+    if( verbose != 0 )
+        printf( "\n" );
+
+    /*
+     * CBC mode, independent streams encrypted block by block in turn
+     */
+    if( verbose != 0 )
+        printf( "  AES-CBC (enc, %d interleaved streams): ", AES_STREAMS );
+
+    for( j = 0; j < AES_BULK_LEN; j++ )
+        bulk_pt[j] = (unsigned char)( j * 13 );
+
+    for( i = 0; i < AES_STREAMS; i++ )
+    {
+        memset( stream_key, 0, 32 );
+        stream_key[0] = (unsigned char) i;
+        aes_setkey_enc( &stream_ctx[i], stream_key, 128 + ( i % 3 ) * 64 );
+
+        memset( iv, i, 16 );
+        aes_crypt_cbc( &stream_ctx[i], AES_ENCRYPT, AES_STREAM_LEN, iv,
+                       bulk_pt + i * AES_STREAM_LEN,
+                       bulk_ct + i * AES_STREAM_LEN );
+
+        memset( stream_iv[i], i, 16 );
+    }
+
+    for( j = 0; j < AES_STREAM_LEN; j += 16 )
+        for( i = 0; i < AES_STREAMS; i++ )
+            aes_crypt_cbc( &stream_ctx[i], AES_ENCRYPT, 16, stream_iv[i],
+                           bulk_pt  + i * AES_STREAM_LEN + j,
+                           bulk_buf + i * AES_STREAM_LEN + j );
+
+    for( i = 0; i < AES_STREAMS; i++ )
+    {
+        p = bulk_buf + ( i + 1 ) * AES_STREAM_LEN - 16;
+
+        if( memcmp( bulk_buf + i * AES_STREAM_LEN,
+                    bulk_ct  + i * AES_STREAM_LEN, AES_STREAM_LEN ) != 0 ||
+            memcmp( stream_iv[i], p, 16 ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+    }
+
+    if( verbose != 0 )
+        printf( "passed\n\n" );
+
     return( 0 );
 }
@@ -58,13 +58,17 @@ static const unsigned char arc4_test_ct[3][8] =
     { 0xDE, 0x18, 0x89, 0x41, 0xA3, 0x37, 0x5D, 0x3A }
 };
 
+#define ARC4_BULK_LEN   1031
+
 int verbose = 1;
 
 int
 main(void)
 {
-    int i;
+    int i, j, n;
     unsigned char buf[8];
+    unsigned char bulk_ref[ARC4_BULK_LEN];
+    unsigned char bulk_buf[ARC4_BULK_LEN];
     arc4_context ctx;
 
     for( i = 0; i < 3; i++ )
@@ -89,6 +93,50 @@ main(void)
             printf( "passed\n" );
     }
 
+    if( verbose != 0 )
+        printf( "\n" );
+
+    /*
+     * The keystream must not depend on how the input is split up
+     */
+    for( i = 0; i < 3; i++ )
+    {
+        if( verbose != 0 )
+            printf( "  ARC4 test #%d (%d bytes, chunked): ", i + 1,
+                    ARC4_BULK_LEN );
+
+        for( j = 0; j < ARC4_BULK_LEN; j++ )
+            bulk_ref[j] = (unsigned char)( j * 7 );
+
+        memcpy( bulk_buf, bulk_ref, ARC4_BULK_LEN );
+
+        arc4_setup( &ctx, (unsigned char *) arc4_test_key[i], 8 );
+        arc4_crypt( &ctx, bulk_ref, ARC4_BULK_LEN );
+
+        arc4_setup( &ctx, (unsigned char *) arc4_test_key[i], 8 );
+
+        for( j = 0; j < ARC4_BULK_LEN; j += n )
+        {
+            n = ( j % 67 ) + 1;
+
+            if( n > ARC4_BULK_LEN - j )
+                n = ARC4_BULK_LEN - j;
+
+            arc4_crypt( &ctx, bulk_buf + j, n );
+        }
+
+        if( memcmp( bulk_buf, bulk_ref, ARC4_BULK_LEN ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        if( verbose != 0 )
+            printf( "passed\n" );
+    }
+
     if( verbose != 0 )
         printf( "\n" );
 
@@ -48,13 +48,32 @@ static const unsigned char base64_test_enc[] =
     "JEhuVodiWr2/F9mixBcaAZTtjx4Rs9cJDLbpEG8i7hPK"
     "swcFdsn6MWwINP+Nwmw4AEPpVJevUEvRQbqVMVoLlw==";
 
+/*
+ * Inputs that must be rejected
+ */
+static const char *base64_test_bad[5] =
+{
+    "JEhu*odiWr2/F9mi",                 /* invalid character       */
+    "JEhuVodi-r2_F9mi",                 /* URL-safe alphabet       */
+    "JEhuVodi\xC1r2/F9mi",              /* 8-bit character         */
+    "JEhuVo==Wr2/F9mi",                 /* data after padding      */
+    "JEhuVodiWr2/F==="                  /* too much padding        */
+};
+
+#define BASE64_BULK_LEN 1024
+
 int verbose = 1;
 
 int
 main(void)
 {
-    int len;
+    int i, j, n, len;
+    unsigned long x;
     unsigned char *src, buffer[128];
+    unsigned char bulk_dec[BASE64_BULK_LEN];
+    unsigned char bulk_enc[BASE64_BULK_LEN * 2];
+    unsigned char bulk_pem[BASE64_BULK_LEN * 2];
+    unsigned char bulk_buf[BASE64_BULK_LEN + 4];
 
     if( verbose != 0 )
         printf( "  Base64 encoding test: " );
@@ -86,6 +105,125 @@ main(void)
         return( 1 );
     }
 
+    if( verbose != 0 )
+        printf( "passed\n  Base64 short buffers: " );
+
+    len = 87;
+    src = (unsigned char *) base64_test_dec;
+
+    if( base64_encode( buffer, &len, src, 64 ) !=
+            XYSSL_ERR_BASE64_BUFFER_TOO_SMALL || len != 89 )
+    {
+        if( verbose != 0 )
+            printf( "failed\n" );
+
+        return( 1 );
+    }
+
+    len = 63;
+    src = (unsigned char *) base64_test_enc;
+
+    if( base64_decode( buffer, &len, src, 88 ) !=
+            XYSSL_ERR_BASE64_BUFFER_TOO_SMALL || len != 66 )
+    {
+        if( verbose != 0 )
+            printf( "failed\n" );
+
+        return( 1 );
+    }
+
+    if( verbose != 0 )
+        printf( "passed\n  Base64 invalid input: " );
+
+    for( i = 0; i < 5; i++ )
+    {
+        len = sizeof( buffer );
+        src = (unsigned char *) base64_test_bad[i];
+
+        if( base64_decode( buffer, &len, src, strlen( base64_test_bad[i] ) )
+                != XYSSL_ERR_BASE64_INVALID_CHARACTER )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+    }
+
+    if( verbose != 0 )
+        printf( "passed\n  Base64 round trip (1 to %d bytes): ",
+                BASE64_BULK_LEN );
+
+    for( x = 1, i = 0; i < BASE64_BULK_LEN; i++ )
+    {
+        x = x * 1103515245 + 12345;
+        bulk_dec[i] = (unsigned char)( x >> 16 );
+    }
+
+    for( i = 1; i <= BASE64_BULK_LEN; i++ )
+    {
+        len = sizeof( bulk_enc );
+
+        if( base64_encode( bulk_enc, &len, bulk_dec, i ) != 0 ||
+            len != ( ( i + 2 ) / 3 ) * 4 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        n = len;
+        len = sizeof( bulk_buf );
+
+        if( base64_decode( bulk_buf, &len, bulk_enc, n ) != 0 ||
+            len != i || memcmp( bulk_buf, bulk_dec, i ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+    }
+
+    /*
+     * PEM-style line breaks, as found in certs.h, must be skipped
+     */
+    for( j = 0; j < 2; j++ )
+    {
+        if( verbose != 0 )
+            printf( "passed\n  Base64 decoding with %s line breaks: ",
+                    ( j == 0 ) ? "CRLF" : "LF" );
+
+        len = sizeof( bulk_enc );
+        base64_encode( bulk_enc, &len, bulk_dec, BASE64_BULK_LEN );
+
+        for( i = n = 0; i < len; i++ )
+        {
+            bulk_pem[n++] = bulk_enc[i];
+
+            if( ( i % 64 ) == 63 || i == len - 1 )
+            {
+                if( j == 0 )
+                    bulk_pem[n++] = '\r';
+
+                bulk_pem[n++] = '\n';
+            }
+        }
+
+        len = sizeof( bulk_buf );
+
+        if( base64_decode( bulk_buf, &len, bulk_pem, n ) != 0 ||
+            len != BASE64_BULK_LEN ||
+            memcmp( bulk_buf, bulk_dec, BASE64_BULK_LEN ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+    }
+
     if( verbose != 0 )
         printf( "passed\n\n" );
 
@@ -31,15 +31,36 @@
 
 #include <ssl/bignum.h>
 
+static unsigned long test_seed = 1;
+
+/*
+ * Deterministic filler for the randomized tests, so failures reproduce
+ */
+static void
+test_fill(unsigned char *buf, int len)
+{
+    while( len-- > 0 )
+    {
+        test_seed = test_seed * 1103515245 + 12345;
+        *buf++ = (unsigned char)( test_seed >> 16 );
+    }
+}
+
+/*
+ * Exponent sizes in bytes, one for each sliding window width
+ */
+static const int test_exp_len[5] = { 2, 8, 24, 64, 0 };
+
 int verbose = 1;
 
 int
 main(void)
 {
-    int ret;
-    mpi A, E, N, X, Y, U, V;
+    int ret, i, j, k, m, n;
+    unsigned char buf[1040];
+    mpi A, E, N, X, Y, U, V, RR;
 
-    mpi_init( &A, &E, &N, &X, &Y, &U, &V, NULL );
+    mpi_init( &A, &E, &N, &X, &Y, &U, &V, &RR, NULL );
 
     MPI_CHK( mpi_read_string( &A, 16,
         "EFE021C2645FD1DC586E69184AF4A31E" \
@@ -150,12 +171,276 @@ main(void)
     if( verbose != 0 )
         printf( "passed\n" );
 
+    /*
+     * Random operands of unequal length, up to 8216 bits, so that every
+     * multiplication size threshold is crossed; the product must divide
+     * back exactly into its factors
+     */
+    if( verbose != 0 )
+        printf( "  MPI test #5 (mul_mpi, random): " );
+
+    for( i = 1; i <= 64; i++ )
+    {
+        test_fill( buf, i * 16 );
+        MPI_CHK( mpi_read_binary( &A, buf, i * 16 ) );
+
+        test_fill( buf, ( 65 - i ) * 16 + 3 );
+        MPI_CHK( mpi_read_binary( &N, buf, ( 65 - i ) * 16 + 3 ) );
+
+        MPI_CHK( mpi_mul_mpi( &X, &A, &N ) );
+        MPI_CHK( mpi_mul_mpi( &Y, &N, &A ) );
+        MPI_CHK( mpi_div_mpi( &U, &V, &X, &N ) );
+
+        if( mpi_cmp_mpi( &X, &Y ) != 0 ||
+            mpi_cmp_mpi( &U, &A ) != 0 ||
+            mpi_cmp_int( &V, 0 ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+    }
+
+    if( verbose != 0 )
+        printf( "passed\n" );
+
+    /*
+     * A squared must match A times a copy of A, both directly and as
+     * the only step of a modular exponentiation
+     */
+    if( verbose != 0 )
+        printf( "  MPI test #6 (squaring): " );
+
+    MPI_CHK( mpi_lset( &E, 2 ) );
+
+    for( i = 1; i <= 32; i++ )
+    {
+        test_fill( buf, i * 32 );
+        MPI_CHK( mpi_read_binary( &A, buf, i * 32 ) );
+        MPI_CHK( mpi_copy( &N, &A ) );
+
+        test_fill( buf, i * 32 + 1 );
+        buf[i * 32] |= 1;
+        MPI_CHK( mpi_read_binary( &U, buf, i * 32 + 1 ) );
+
+        MPI_CHK( mpi_mul_mpi( &X, &A, &A ) );
+        MPI_CHK( mpi_mul_mpi( &Y, &A, &N ) );
+
+        if( mpi_cmp_mpi( &X, &Y ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        MPI_CHK( mpi_mod_mpi( &Y, &X, &U ) );
+        MPI_CHK( mpi_exp_mod( &V, &A, &E, &U, NULL ) );
+
+        if( mpi_cmp_mpi( &V, &Y ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+    }
+
+    if( verbose != 0 )
+        printf( "passed\n" );
+
+    /*
+     * Per-modulus precomputation cached in _RR by the first call must
+     * give the same results as computing it afresh every time
+     */
+    if( verbose != 0 )
+        printf( "  MPI test #7 (exp_mod, cached R^2): " );
+
+    test_fill( buf, 256 );
+    buf[0] |= 0x80;
+    buf[255] |= 1;
+    MPI_CHK( mpi_read_binary( &N, buf, 256 ) );
+
+    for( i = 0; i < 8; i++ )
+    {
+        test_fill( buf, 255 );
+        MPI_CHK( mpi_read_binary( &A, buf, 255 ) );
+
+        test_fill( buf, 32 + i * 28 );
+        MPI_CHK( mpi_read_binary( &E, buf, 32 + i * 28 ) );
+
+        MPI_CHK( mpi_exp_mod( &X, &A, &E, &N, &RR ) );
+        MPI_CHK( mpi_exp_mod( &Y, &A, &E, &N, NULL ) );
+
+        if( mpi_cmp_mpi( &X, &Y ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+    }
+
+    if( verbose != 0 )
+        printf( "passed\n" );
+
+    /*
+     * 1024- to 4096-bit moduli, each with exponents sized for every window
+     * width and a full-length one, against plain square-and-multiply
+     */
+    if( verbose != 0 )
+        printf( "  MPI test #8 (exp_mod, window sizes): " );
+
+    for( i = 1; i <= 4; i++ )
+    {
+        m = i * 128;
+
+        test_fill( buf, m );
+        buf[0] |= 0x80;
+        buf[m - 1] |= 1;
+        MPI_CHK( mpi_read_binary( &N, buf, m ) );
+
+        for( j = 0; j < 5; j++ )
+        {
+            n = ( test_exp_len[j] != 0 ) ? test_exp_len[j] : m;
+
+            test_fill( buf, m - 1 );
+            MPI_CHK( mpi_read_binary( &A, buf, m - 1 ) );
+
+            test_fill( buf, n );
+            buf[0] |= 0x80;
+            MPI_CHK( mpi_read_binary( &E, buf, n ) );
+
+            MPI_CHK( mpi_exp_mod( &X, &A, &E, &N, NULL ) );
+
+            MPI_CHK( mpi_lset( &Y, 1 ) );
+
+            for( k = 0; k < n * 8; k++ )
+            {
+                MPI_CHK( mpi_mul_mpi( &U, &Y, &Y ) );
+                MPI_CHK( mpi_mod_mpi( &Y, &U, &N ) );
+
+                if( ( buf[k >> 3] >> ( 7 - ( k & 7 ) ) ) & 1 )
+                {
+                    MPI_CHK( mpi_mul_mpi( &U, &Y, &A ) );
+                    MPI_CHK( mpi_mod_mpi( &Y, &U, &N ) );
+                }
+            }
+
+            if( mpi_cmp_mpi( &X, &Y ) != 0 )
+            {
+                if( verbose != 0 )
+                    printf( "failed\n" );
+
+                return( 1 );
+            }
+        }
+    }
+
+    if( verbose != 0 )
+        printf( "passed\n" );
+
+    /*
+     * All-ones operands carry through every limb: (2^i - 1)^2 must be
+     * 2^2i - 2^(i+1) + 1, and with N = 2^i - 1, (N - 2)^3 mod N = N - 8
+     */
+    if( verbose != 0 )
+        printf( "  MPI test #9 (carry propagation): " );
+
+    MPI_CHK( mpi_lset( &E, 3 ) );
+
+    for( i = 1; i <= 520; i++ )
+    {
+        MPI_CHK( mpi_lset( &N, 1 ) );
+        MPI_CHK( mpi_shift_l( &N, i ) );
+        MPI_CHK( mpi_sub_int( &N, &N, 1 ) );
+
+        MPI_CHK( mpi_mul_mpi( &X, &N, &N ) );
+
+        MPI_CHK( mpi_lset( &Y, 1 ) );
+        MPI_CHK( mpi_shift_l( &Y, i * 2 ) );
+        MPI_CHK( mpi_lset( &U, 1 ) );
+        MPI_CHK( mpi_shift_l( &U, i + 1 ) );
+        MPI_CHK( mpi_sub_mpi( &Y, &Y, &U ) );
+        MPI_CHK( mpi_add_int( &Y, &Y, 1 ) );
+
+        if( mpi_cmp_mpi( &X, &Y ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        if( i < 4 )
+            continue;
+
+        MPI_CHK( mpi_sub_int( &A, &N, 2 ) );
+        MPI_CHK( mpi_exp_mod( &X, &A, &E, &N, NULL ) );
+        MPI_CHK( mpi_sub_int( &Y, &N, 8 ) );
+
+        if( mpi_cmp_mpi( &X, &Y ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+    }
+
+    if( verbose != 0 )
+        printf( "passed\n" );
+
+    /*
+     * Random dividends and divisors with saturated, minimal and random
+     * top bytes: A = Q * B + R with 0 <= R < B
+     */
+    if( verbose != 0 )
+        printf( "  MPI test #10 (div_mpi, random): " );
+
+    for( i = 1; i <= 64; i++ )
+    {
+        n = i * 16 + 5;
+        test_fill( buf, n );
+        MPI_CHK( mpi_read_binary( &A, buf, n ) );
+
+        n = ( ( i * 7 ) % 64 + 1 ) * 8;
+        test_fill( buf, n );
+
+        if( i % 3 == 0 )
+            buf[0] = 0xFF;
+        else if( i % 3 == 1 )
+            buf[0] = 0x80;
+
+        buf[n - 1] |= 1;
+        MPI_CHK( mpi_read_binary( &N, buf, n ) );
+
+        MPI_CHK( mpi_div_mpi( &X, &Y, &A, &N ) );
+
+        MPI_CHK( mpi_mul_mpi( &U, &X, &N ) );
+        MPI_CHK( mpi_add_mpi( &U, &U, &Y ) );
+
+        if( mpi_cmp_mpi( &U, &A ) != 0 ||
+            mpi_cmp_int( &Y, 0 ) < 0 ||
+            mpi_cmp_mpi( &Y, &N ) >= 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+    }
+
+    if( verbose != 0 )
+        printf( "passed\n" );
+
 cleanup:
 
     if( ret != 0 && verbose != 0 )
         printf( "Unexpected error, return code = %08X\n", ret );
 
-    mpi_free( &V, &U, &Y, &X, &N, &E, &A, NULL );
+    mpi_free( &RR, &V, &U, &Y, &X, &N, &E, &A, NULL );
 
     if( verbose != 0 )
         printf( "\n" );
@@ -82,6 +82,8 @@ static const unsigned char des3_test_cbc_enc[3][8] =
     { 0xCB, 0x19, 0x1F, 0x85, 0xD1, 0xED, 0x84, 0x39 }
 };
 
+#define DES3_BULK_LEN   ( 67 * 8 )
+
 int verbose = 1;
 
 int
@@ -94,6 +96,9 @@ main(void)
     unsigned char buf[8];
     unsigned char prv[8];
     unsigned char iv[8];
+    unsigned char bulk_pt[DES3_BULK_LEN];
+    unsigned char bulk_ct[DES3_BULK_LEN];
+    unsigned char bulk_buf[DES3_BULK_LEN];
 
     memset( key, 0, 24 );
 
@@ -259,6 +264,140 @@ main(void)
             printf( "passed\n" );
     }
 
+    if( verbose != 0 )
+        printf( "\n" );
+
+    /*
+     * 3DES-CBC, multi-block decryption
+     */
+    for( i = 0; i < 2; i++ )
+    {
+        if( verbose != 0 )
+            printf( "  DES3-CBC-%3d (dec, %d bytes): ", 112 + i * 56,
+                    DES3_BULK_LEN );
+
+        for( j = 0; j < DES3_BULK_LEN; j++ )
+            bulk_pt[j] = (unsigned char)( j * 7 + i );
+
+        if( i == 0 )
+            des3_set2key_enc( &ctx3, (unsigned char *) des3_test_keys );
+        else
+            des3_set3key_enc( &ctx3, (unsigned char *) des3_test_keys );
+
+        memcpy( iv, des3_test_iv, 8 );
+        des3_crypt_cbc( &ctx3, DES_ENCRYPT, DES3_BULK_LEN, iv,
+                        bulk_pt, bulk_ct );
+
+        if( i == 0 )
+            des3_set2key_dec( &ctx3, (unsigned char *) des3_test_keys );
+        else
+            des3_set3key_dec( &ctx3, (unsigned char *) des3_test_keys );
+
+        /*
+         * whole buffer in one call, in place
+         */
+        memcpy( bulk_buf, bulk_ct, DES3_BULK_LEN );
+        memcpy( iv, des3_test_iv, 8 );
+        des3_crypt_cbc( &ctx3, DES_DECRYPT, DES3_BULK_LEN, iv,
+                        bulk_buf, bulk_buf );
+        memcpy( prv, iv, 8 );
+
+        if( memcmp( bulk_buf, bulk_pt, DES3_BULK_LEN ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        /*
+         * one block at a time, the chaining value must end up the same
+         */
+        memcpy( iv, des3_test_iv, 8 );
+
+        for( j = 0; j < DES3_BULK_LEN; j += 8 )
+        {
+            des3_crypt_cbc( &ctx3, DES_DECRYPT, 8, iv, bulk_ct + j, buf );
+
+            if( memcmp( buf, bulk_pt + j, 8 ) != 0 )
+            {
+                if( verbose != 0 )
+                    printf( "failed\n" );
+
+                return( 1 );
+            }
+        }
+
+        if( memcmp( iv, prv, 8 ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        if( verbose != 0 )
+            printf( "passed\n" );
+    }
+
+    if( verbose != 0 )
+        printf( "\n" );
+
+    /*
+     * 3DES with K1 = K2 = K3 must reduce to single DES
+     */
+    for( i = 0; i < 3; i++ )
+        memcpy( key + i * 8, des3_test_keys, 8 );
+
+    for( i = 0; i < 4; i++ )
+    {
+        u = i >> 1;
+        v = i  & 1;
+
+        if( verbose != 0 )
+            printf( "  DES3-ECB-%3d (%s, K1 = K2 = K3): ", 112 + u * 56,
+                    ( v == DES_DECRYPT ) ? "dec" : "enc" );
+
+        if( v == DES_DECRYPT )
+        {
+            des_setkey_dec( &ctx, key );
+
+            if( u == 0 )
+                des3_set2key_dec( &ctx3, key );
+            else
+                des3_set3key_dec( &ctx3, key );
+        }
+        else
+        {
+            des_setkey_enc( &ctx, key );
+
+            if( u == 0 )
+                des3_set2key_enc( &ctx3, key );
+            else
+                des3_set3key_enc( &ctx3, key );
+        }
+
+        for( j = 0; j < DES3_BULK_LEN; j++ )
+            bulk_pt[j] = (unsigned char)( j * 11 + i );
+
+        for( j = 0; j < DES3_BULK_LEN; j += 8 )
+        {
+            des_crypt_ecb( &ctx, bulk_pt + j, bulk_ct + j );
+            des3_crypt_ecb( &ctx3, bulk_pt + j, bulk_buf + j );
+        }
+
+        if( memcmp( bulk_buf, bulk_ct, DES3_BULK_LEN ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        if( verbose != 0 )
+            printf( "passed\n" );
+    }
+
     if( verbose != 0 )
         printf( "\n" );
 
@@ -28,7 +28,9 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <ssl/md5.h>
 
@@ -133,14 +135,24 @@ static const unsigned char md5_hmac_test_sum[7][16] =
       0x1F, 0xB1, 0xF5, 0x62, 0xDB, 0x3A, 0xA5, 0x3E }
 };
 
+/*
+ * Update sizes for the split test: partial, whole and several blocks
+ */
+static const int md5_test_chunk[10] =
+{
+    1, 63, 64, 65, 127, 128, 129, 191, 200, 1000
+};
+
 int verbose = 1;
 
 int
 main(void)
 {
-    int i, buflen;
+    int i, j, m, n, fd, ret, buflen;
+    char path[32];
     unsigned char buf[1024];
     unsigned char md5sum[16];
+    unsigned char md5ref[16];
     md5_context ctx;
 
     for( i = 0; i < 7; i++ )
@@ -165,6 +177,137 @@ main(void)
     if( verbose != 0 )
         printf( "\n" );
 
+    /*
+     * Same messages from unaligned addresses, in one call and byte by byte
+     */
+    for( i = 0; i < 7; i++ )
+    {
+        if( verbose != 0 )
+            printf( "  MD5 test #%d (split): ", i + 1 );
+
+        memcpy( buf + i + 1, md5_test_buf[i], md5_test_buflen[i] );
+        md5( buf + i + 1, md5_test_buflen[i], md5ref );
+
+        md5_starts( &ctx );
+
+        for( j = 0; j < md5_test_buflen[i]; j++ )
+            md5_update( &ctx, buf + i + 1 + j, 1 );
+
+        md5_finish( &ctx, md5sum );
+
+        if( memcmp( md5ref, md5_test_sum[i], 16 ) != 0 ||
+            memcmp( md5sum, md5_test_sum[i], 16 ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        if( verbose != 0 )
+            printf( "passed\n" );
+    }
+
+    /*
+     * A multi-block message must not depend on how it is split up, nor
+     * on the alignment of the blocks read from the caller's buffer
+     */
+    if( verbose != 0 )
+        printf( "  MD5 test (1000 bytes, split): " );
+
+    for( j = 0; j < 1000; j++ )
+        buf[j] = (unsigned char)( j * 7 );
+
+    md5( buf, 1000, md5ref );
+
+    for( i = 1; i < 8; i++ )
+    {
+        for( j = 0; j < 1000; j++ )
+            buf[i + j] = (unsigned char)( j * 7 );
+
+        md5_starts( &ctx );
+
+        for( j = m = 0; j < 1000; j += n, m++ )
+        {
+            n = md5_test_chunk[m % 10];
+
+            if( n > 1000 - j )
+                n = 1000 - j;
+
+            md5_update( &ctx, buf + i + j, n );
+        }
+
+        md5_finish( &ctx, md5sum );
+
+        if( memcmp( md5sum, md5ref, 16 ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+    }
+
+    if( verbose != 0 )
+        printf( "passed\n\n" );
+
+    /*
+     * md5_file over each message, and the empty file
+     */
+    for( i = 0; i < 7; i++ )
+    {
+        if( verbose != 0 )
+            printf( "  MD5 file test #%d: ", i + 1 );
+
+        strcpy( path, "md5.XXXXXXXXXX" );
+
+        if( ( fd = mkstemp( path ) ) == -1 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        ret = 0;
+
+        if( write( fd, md5_test_buf[i], md5_test_buflen[i] ) !=
+                md5_test_buflen[i] )
+            ret = 1;
+
+        close( fd );
+
+        if( ret == 0 )
+            ret = md5_file( path, md5sum );
+
+        unlink( path );
+
+        if( ret != 0 || memcmp( md5sum, md5_test_sum[i], 16 ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        if( verbose != 0 )
+            printf( "passed\n" );
+    }
+
+    if( verbose != 0 )
+        printf( "  MD5 file test (missing file): " );
+
+    if( md5_file( path, md5sum ) == 0 )
+    {
+        if( verbose != 0 )
+            printf( "failed\n" );
+
+        return( 1 );
+    }
+
+    if( verbose != 0 )
+        printf( "passed\n\n" );
+
     for( i = 0; i < 7; i++ )
     {
         if( verbose != 0 )
@@ -28,7 +28,9 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <ssl/sha1.h>
 
@@ -57,6 +59,15 @@ static const unsigned char sha1_test_sum[3][20] =
       0xEB, 0x2B, 0xDB, 0xAD, 0x27, 0x31, 0x65, 0x34, 0x01, 0x6F }
 };
 
+/*
+ * Digest of the empty message
+ */
+static const unsigned char sha1_test_empty_sum[20] =
+{
+    0xDA, 0x39, 0xA3, 0xEE, 0x5E, 0x6B, 0x4B, 0x0D, 0x32, 0x55,
+    0xBF, 0xEF, 0x95, 0x60, 0x18, 0x90, 0xAF, 0xD8, 0x07, 0x09
+};
+
 /*
  * RFC 2202 test vectors
  */
@@ -123,14 +134,24 @@ static const unsigned char sha1_hmac_test_sum[7][20] =
       0xBA, 0xA7, 0x96, 0x5C, 0x78, 0x08, 0xBB, 0xFF, 0x1A, 0x91 }
 };
 
+/*
+ * Update sizes for the split tests: partial, whole and several blocks
+ */
+static const int sha1_test_chunk[10] =
+{
+    1, 63, 64, 65, 127, 128, 129, 191, 200, 1000
+};
+
 int verbose = 1;
 
 int
 main(void)
 {
-    int i, j, buflen;
+    int i, j, m, n, fd, ret, buflen;
+    char path[32];
     unsigned char buf[1024];
     unsigned char sha1sum[20];
+    unsigned char sha1ref[20];
     sha1_context ctx;
 
     /*
@@ -171,6 +192,119 @@ main(void)
     if( verbose != 0 )
         printf( "\n" );
 
+    /*
+     * SHA-1, same messages split at irregular, unaligned boundaries
+     */
+    for( i = 0; i < 3; i++ )
+    {
+        if( verbose != 0 )
+            printf( "  SHA-1 test #%d (split): ", i + 1 );
+
+        sha1_starts( &ctx );
+
+        if( i == 2 )
+        {
+            memset( buf, 'a', sizeof( buf ) );
+
+            for( j = m = 0; j < 1000000; j += n, m++ )
+            {
+                n = sha1_test_chunk[m % 10];
+
+                if( n > 1000000 - j )
+                    n = 1000000 - j;
+
+                sha1_update( &ctx, buf + ( j & 7 ), n );
+            }
+        }
+        else
+        {
+            for( j = 0; j < sha1_test_buflen[i]; j++ )
+                sha1_update( &ctx, sha1_test_buf[i] + j, 1 );
+        }
+
+        sha1_finish( &ctx, sha1sum );
+
+        if( memcmp( sha1sum, sha1_test_sum[i], 20 ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        if( verbose != 0 )
+            printf( "passed\n" );
+    }
+
+    if( verbose != 0 )
+        printf( "\n" );
+
+    /*
+     * sha1_file over an empty file and the million-'a' message
+     */
+    for( i = 0; i < 2; i++ )
+    {
+        if( verbose != 0 )
+            printf( "  SHA-1 file test #%d: ", i + 1 );
+
+        strcpy( path, "sha1.XXXXXXXXXX" );
+
+        if( ( fd = mkstemp( path ) ) == -1 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        memset( buf, 'a', buflen = 1000 );
+        ret = 0;
+
+        if( i == 1 )
+        {
+            for( n = 0; n < 1000; n++ )
+                if( write( fd, buf, buflen ) != buflen )
+                    ret = 1;
+        }
+
+        close( fd );
+
+        if( ret == 0 )
+            ret = sha1_file( path, sha1sum );
+
+        unlink( path );
+
+        if( i == 0 )
+            memcpy( sha1ref, sha1_test_empty_sum, 20 );
+        else
+            memcpy( sha1ref, sha1_test_sum[2], 20 );
+
+        if( ret != 0 || memcmp( sha1sum, sha1ref, 20 ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        if( verbose != 0 )
+            printf( "passed\n" );
+    }
+
+    if( verbose != 0 )
+        printf( "  SHA-1 file test (missing file): " );
+
+    if( sha1_file( path, sha1sum ) == 0 )
+    {
+        if( verbose != 0 )
+            printf( "failed\n" );
+
+        return( 1 );
+    }
+
+    if( verbose != 0 )
+        printf( "passed\n\n" );
+
     for( i = 0; i < 7; i++ )
     {
         if( verbose != 0 )
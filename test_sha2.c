@@ -28,7 +28,9 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <ssl/sha2.h>
 
@@ -82,6 +84,28 @@ static const unsigned char sha2_test_sum[6][32] =
       0x04, 0x6D, 0x39, 0xCC, 0xC7, 0x11, 0x2C, 0xD0 }
 };
 
+/*
+ * Digests of the empty message
+ */
+static const unsigned char sha2_test_empty_sum[2][32] =
+{
+    /*
+     * SHA-224
+     */
+    { 0xD1, 0x4A, 0x02, 0x8C, 0x2A, 0x3A, 0x2B, 0xC9,
+      0x47, 0x61, 0x02, 0xBB, 0x28, 0x82, 0x34, 0xC4,
+      0x15, 0xA2, 0xB0, 0x1F, 0x82, 0x8E, 0xA6, 0x2A,
+      0xC5, 0xB3, 0xE4, 0x2F },
+
+    /*
+     * SHA-256
+     */
+    { 0xE3, 0xB0, 0xC4, 0x42, 0x98, 0xFC, 0x1C, 0x14,
+      0x9A, 0xFB, 0xF4, 0xC8, 0x99, 0x6F, 0xB9, 0x24,
+      0x27, 0xAE, 0x41, 0xE4, 0x64, 0x9B, 0x93, 0x4C,
+      0xA4, 0x95, 0x99, 0x1B, 0x78, 0x52, 0xB8, 0x55 }
+};
+
 /*
  * RFC 4231 test vectors
  */
@@ -194,14 +218,24 @@ static const unsigned char sha2_hmac_test_sum[14][32] =
       0x8A, 0x7F, 0x51, 0x53, 0x5C, 0x3A, 0x35, 0xE2 }
 };
 
+/*
+ * Update sizes for the split tests: partial, whole and several blocks
+ */
+static const int sha2_test_chunk[10] =
+{
+    1, 63, 64, 65, 127, 128, 129, 191, 200, 1000
+};
+
 int verbose = 1;
 
 int
 main(void)
 {
-    int i, j, k, buflen;
+    int i, j, k, m, n, fd, ret, buflen;
+    char path[32];
     unsigned char buf[1024];
     unsigned char sha2sum[32];
+    unsigned char sha2ref[32];
     sha2_context ctx;
 
     for( i = 0; i < 6; i++ )
@@ -242,6 +276,125 @@ main(void)
     if( verbose != 0 )
         printf( "\n" );
 
+    /*
+     * SHA-224/256, same messages split at irregular, unaligned boundaries
+     */
+    for( i = 0; i < 6; i++ )
+    {
+        j = i % 3;
+        k = i < 3;
+
+        if( verbose != 0 )
+            printf( "  SHA-%d test #%d (split): ", 256 - k * 32, j + 1 );
+
+        sha2_starts( &ctx, k );
+
+        if( j == 2 )
+        {
+            memset( buf, 'a', sizeof( buf ) );
+
+            for( j = m = 0; j < 1000000; j += n, m++ )
+            {
+                n = sha2_test_chunk[m % 10];
+
+                if( n > 1000000 - j )
+                    n = 1000000 - j;
+
+                sha2_update( &ctx, buf + ( j & 7 ), n );
+            }
+        }
+        else
+        {
+            for( n = 0; n < sha2_test_buflen[j]; n++ )
+                sha2_update( &ctx, sha2_test_buf[j] + n, 1 );
+        }
+
+        sha2_finish( &ctx, sha2sum );
+
+        if( memcmp( sha2sum, sha2_test_sum[i], 32 - k * 4 ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        if( verbose != 0 )
+            printf( "passed\n" );
+    }
+
+    if( verbose != 0 )
+        printf( "\n" );
+
+    /*
+     * sha2_file over an empty file and the million-'a' message
+     */
+    for( i = 0; i < 4; i++ )
+    {
+        j = i % 2;
+        k = i < 2;
+
+        if( verbose != 0 )
+            printf( "  SHA-%d file test #%d: ", 256 - k * 32, j + 1 );
+
+        strcpy( path, "sha2.XXXXXXXXXX" );
+
+        if( ( fd = mkstemp( path ) ) == -1 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        memset( buf, 'a', buflen = 1000 );
+        ret = 0;
+
+        if( j == 1 )
+        {
+            for( n = 0; n < 1000; n++ )
+                if( write( fd, buf, buflen ) != buflen )
+                    ret = 1;
+        }
+
+        close( fd );
+
+        if( ret == 0 )
+            ret = sha2_file( path, sha2sum, k );
+
+        unlink( path );
+
+        if( j == 0 )
+            memcpy( sha2ref, sha2_test_empty_sum[1 - k], 32 - k * 4 );
+        else
+            memcpy( sha2ref, sha2_test_sum[5 - k * 3], 32 - k * 4 );
+
+        if( ret != 0 || memcmp( sha2sum, sha2ref, 32 - k * 4 ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        if( verbose != 0 )
+            printf( "passed\n" );
+    }
+
+    if( verbose != 0 )
+        printf( "  SHA-256 file test (missing file): " );
+
+    if( sha2_file( path, sha2sum, k ) == 0 )
+    {
+        if( verbose != 0 )
+            printf( "failed\n" );
+
+        return( 1 );
+    }
+
+    if( verbose != 0 )
+        printf( "passed\n\n" );
+
     for( i = 0; i < 14; i++ )
     {
         j = i % 7;
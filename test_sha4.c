@@ -28,7 +28,9 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <ssl/sha4.h>
 
@@ -101,6 +103,34 @@ static const unsigned char sha4_test_sum[6][64] =
       0x4E, 0xAD, 0xB2, 0x17, 0xAD, 0x8C, 0xC0, 0x9B }
 };
 
+/*
+ * Digests of the empty message
+ */
+static const unsigned char sha4_test_empty_sum[2][64] =
+{
+    /*
+     * SHA-384
+     */
+    { 0x38, 0xB0, 0x60, 0xA7, 0x51, 0xAC, 0x96, 0x38,
+      0x4C, 0xD9, 0x32, 0x7E, 0xB1, 0xB1, 0xE3, 0x6A,
+      0x21, 0xFD, 0xB7, 0x11, 0x14, 0xBE, 0x07, 0x43,
+      0x4C, 0x0C, 0xC7, 0xBF, 0x63, 0xF6, 0xE1, 0xDA,
+      0x27, 0x4E, 0xDE, 0xBF, 0xE7, 0x6F, 0x65, 0xFB,
+      0xD5, 0x1A, 0xD2, 0xF1, 0x48, 0x98, 0xB9, 0x5B },
+
+    /*
+     * SHA-512
+     */
+    { 0xCF, 0x83, 0xE1, 0x35, 0x7E, 0xEF, 0xB8, 0xBD,
+      0xF1, 0x54, 0x28, 0x50, 0xD6, 0x6D, 0x80, 0x07,
+      0xD6, 0x20, 0xE4, 0x05, 0x0B, 0x57, 0x15, 0xDC,
+      0x83, 0xF4, 0xA9, 0x21, 0xD3, 0x6C, 0xE9, 0xCE,
+      0x47, 0xD0, 0xD1, 0x3C, 0x5D, 0x85, 0xF2, 0xB0,
+      0xFF, 0x83, 0x18, 0xD2, 0x87, 0x7E, 0xEC, 0x2F,
+      0x63, 0xB9, 0x31, 0xBD, 0x47, 0x41, 0x7A, 0x81,
+      0xA5, 0x38, 0x32, 0x7A, 0xF9, 0x27, 0xDA, 0x3E }
+};
+
 /*
  * RFC 4231 test vectors
  */
@@ -249,14 +279,24 @@ static const unsigned char sha4_hmac_test_sum[14][64] =
       0x65, 0xC9, 0x74, 0x40, 0xFA, 0x8C, 0x6A, 0x58 }
 };
 
+/*
+ * Update sizes for the split tests: partial, whole and several blocks
+ */
+static const int sha4_test_chunk[10] =
+{
+    1, 63, 64, 65, 127, 128, 129, 191, 200, 1000
+};
+
 int verbose = 1;
 
 int
 main(void)
 {
-    int i, j, k, buflen;
+    int i, j, k, m, n, fd, ret, buflen;
+    char path[32];
     unsigned char buf[1024];
     unsigned char sha4sum[64];
+    unsigned char sha4ref[64];
     sha4_context ctx;
 
     for( i = 0; i < 6; i++ )
@@ -297,6 +337,125 @@ main(void)
     if( verbose != 0 )
         printf( "\n" );
 
+    /*
+     * SHA-384/512, same messages split at irregular, unaligned boundaries
+     */
+    for( i = 0; i < 6; i++ )
+    {
+        j = i % 3;
+        k = i < 3;
+
+        if( verbose != 0 )
+            printf( "  SHA-%d test #%d (split): ", 512 - k * 128, j + 1 );
+
+        sha4_starts( &ctx, k );
+
+        if( j == 2 )
+        {
+            memset( buf, 'a', sizeof( buf ) );
+
+            for( j = m = 0; j < 1000000; j += n, m++ )
+            {
+                n = sha4_test_chunk[m % 10];
+
+                if( n > 1000000 - j )
+                    n = 1000000 - j;
+
+                sha4_update( &ctx, buf + ( j & 7 ), n );
+            }
+        }
+        else
+        {
+            for( n = 0; n < sha4_test_buflen[j]; n++ )
+                sha4_update( &ctx, sha4_test_buf[j] + n, 1 );
+        }
+
+        sha4_finish( &ctx, sha4sum );
+
+        if( memcmp( sha4sum, sha4_test_sum[i], 64 - k * 16 ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        if( verbose != 0 )
+            printf( "passed\n" );
+    }
+
+    if( verbose != 0 )
+        printf( "\n" );
+
+    /*
+     * sha4_file over an empty file and the million-'a' message
+     */
+    for( i = 0; i < 4; i++ )
+    {
+        j = i % 2;
+        k = i < 2;
+
+        if( verbose != 0 )
+            printf( "  SHA-%d file test #%d: ", 512 - k * 128, j + 1 );
+
+        strcpy( path, "sha4.XXXXXXXXXX" );
+
+        if( ( fd = mkstemp( path ) ) == -1 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        memset( buf, 'a', buflen = 1000 );
+        ret = 0;
+
+        if( j == 1 )
+        {
+            for( n = 0; n < 1000; n++ )
+                if( write( fd, buf, buflen ) != buflen )
+                    ret = 1;
+        }
+
+        close( fd );
+
+        if( ret == 0 )
+            ret = sha4_file( path, sha4sum, k );
+
+        unlink( path );
+
+        if( j == 0 )
+            memcpy( sha4ref, sha4_test_empty_sum[1 - k], 64 - k * 16 );
+        else
+            memcpy( sha4ref, sha4_test_sum[5 - k * 3], 64 - k * 16 );
+
+        if( ret != 0 || memcmp( sha4sum, sha4ref, 64 - k * 16 ) != 0 )
+        {
+            if( verbose != 0 )
+                printf( "failed\n" );
+
+            return( 1 );
+        }
+
+        if( verbose != 0 )
+            printf( "passed\n" );
+    }
+
+    if( verbose != 0 )
+        printf( "  SHA-512 file test (missing file): " );
+
+    if( sha4_file( path, sha4sum, k ) == 0 )
+    {
+        if( verbose != 0 )
+            printf( "failed\n" );
+
+        return( 1 );
+    }
+
+    if( verbose != 0 )
+        printf( "passed\n\n" );
+
     for( i = 0; i < 14; i++ )
     {
         j = i % 7;